@@ -0,0 +1,52 @@
+/*
+  NUX: A kernel Library.
+  Copyright (C) 2019 Gianluca Guida, glguida@tlbflush.org
+
+  SPDX-License-Identifier:	BSD-2-Clause
+*/
+
+#include <stdio.h>
+#include <nux/nux.h>
+#include <nux/plt.h>
+#include <nux/hal.h>
+
+#include "bench.h"
+
+#define CLOCK_LOOPS 100000
+
+static volatile uint64_t sink;
+
+static uint64_t
+clock_div (void)
+{
+  /* The conversion timer_gettime() used to do on every call. */
+  return (plt_tmr_period () * plt_tmr_ctr ()) / 1000000;
+}
+
+static void
+bench_clock_one (const char *name, uint64_t (*fn) (void))
+{
+  uint64_t t0, t1;
+  unsigned i;
+
+  t0 = timer_gettime ();
+  for (i = 0; i < CLOCK_LOOPS; i++)
+    sink = fn ();
+  t1 = timer_gettime ();
+
+  printf ("  %-16s %6" PRIu64 " ns/call\n", name, (t1 - t0) / CLOCK_LOOPS);
+}
+
+/*
+  Cost of reading time.
+*/
+void
+bench_clock (void)
+{
+  printf ("Clock (%d calls, counter period %" PRIu64 " fs):\n",
+	  CLOCK_LOOPS, plt_tmr_period ());
+  bench_clock_one ("timer_gettime", timer_gettime);
+  bench_clock_one ("plt_tmr_ctr", plt_tmr_ctr);
+  bench_clock_one ("ctr+div", clock_div);
+  bench_clock_one ("hal_cpu_cycles", hal_cpu_cycles);
+}
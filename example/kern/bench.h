@@ -0,0 +1,13 @@
+/*
+  NUX: A kernel Library.
+  Copyright (C) 2019 Gianluca Guida, glguida@tlbflush.org
+
+  SPDX-License-Identifier:	BSD-2-Clause
+*/
+
+#ifndef EXAMPLE_BENCH_H
+#define EXAMPLE_BENCH_H
+
+void bench_clock (void);
+
+#endif
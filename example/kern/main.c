@@ -12,8 +12,11 @@
 
 #include <nux/hal.h>
 
+#include "bench.h"
+
 uctxt_t u_init;
-struct hal_umap umap;
+struct umap umap;
+uaddr_t timepage_va;
 
 DEFINE_MEASURE (syscalls_cycles);
 DEFINE_MEASURE (syscalls_nsecs);
@@ -23,6 +26,8 @@ main (int argc, char *argv[])
 {
   printf ("Hello, %s (%" PRIx64 ")!", argv[1], timer_gettime ());
 
+  bench_clock ();
+
   timer_alarm (1 * 1000 * 1000 * 1000);
 
   kmem_trim_setmode (TRIM_BRK);
@@ -56,12 +61,16 @@ main (int argc, char *argv[])
 
   hal_l1p_t l1p;
   hal_l1e_t l1e;
-  hal_umap_bootstrap (&umap);
+  umap_bootstrap (&umap);
   uctxt_print (&u_init);
 
+  timepage_va = hal_virtmem_userbase () + hal_virtmem_usersize () - PAGE_SIZE;
+  if (!timer_umap (&umap, timepage_va))
+    timepage_va = 0;
+
   for (uint64_t i = 0;; i += (1 << 12))
     {
-      uint64_t x = hal_umap_next (&umap, i, &l1p, &l1e);
+      uint64_t x = hal_umap_next (&umap.hal, i, &l1p, &l1e);
       if (x == UADDR_INVALID)
 	break;
       printf ("%lx - %lx(%lx)\n", x, l1p, l1e);
@@ -134,10 +143,16 @@ entry_sysc (uctxt_t * u,
     case 4096:
       putchar (a2);
       break;
+    case 4098:
+      uctxt_setret (u, timepage_va);
+      break;
+    case 4099:
+      uctxt_setret (u, timer_gettime ());
+      break;
     case 4097:
       info ("User exited with error code: %ld", a2);
       hal_umap_load (NULL);
-      hal_umap_free (&umap);
+      hal_umap_free (&umap.hal);
       return UCTXT_IDLE;
 
     default:
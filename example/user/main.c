@@ -1,4 +1,5 @@
 #include <nux/syscalls.h>
+#include <nux/time.h>
 #include <stdio.h>
 
 void
@@ -36,12 +37,36 @@ puts (const char *s)
   return 0;
 }
 
+void
+test_time (void)
+{
+  const struct nux_timepage *tp;
+  uint64_t t0, t1, t2;
+
+  tp = (const struct nux_timepage *) syscall0 (4098);
+  if (tp == NULL)
+    {
+      puts ("No time page.\n");
+      return;
+    }
+
+  t0 = nux_gettime (tp);
+  t1 = (uint64_t) syscall0 (4099);
+  t2 = nux_gettime (tp);
+
+  if (t0 <= t2 && (!(tp->flags & NUX_TIMEPAGE_USERCTR) || t1 <= t2))
+    puts ("Time page test passed.\n");
+  else
+    puts ("Time page test FAILED.\n");
+}
+
 int
 main (void)
 {
   puts ("Hello from userspace, NUX!\n");
 
   test ();
+  test_time ();
 
   return 42;
 }
@@ -130,6 +130,31 @@ void timer_alarm (uint32_t time_ns);
 void timer_clear (void);
 uint64_t timer_gettime (void);
 
+/*
+  Map the read-only time page (see nux/timepage.h) at VA in UMAP.
+*/
+bool timer_umap (struct umap *umap, uaddr_t va);
+
+/*
+  Kernel Software Timers.
+
+  Every CPU has a hierarchical timer wheel. Timers are armed on the
+  current CPU's wheel, and must be cancelled on the same CPU. Insert
+  and cancel are O(1). The hardware alarm is programmed to the
+  earliest pending deadline.
+
+  SLACK allows the timer to expire up to SLACK nanoseconds late, so
+  that it can be coalesced with nearby deadlines.
+
+  Timer callbacks run in the timer interrupt, before entry_alarm(),
+  which is only called for the alarm set with timer_alarm().
+*/
+void ktimer_init (struct ktimer *t, void (*fn) (struct ktimer *, void *),
+		  void *arg);
+void ktimer_set (struct ktimer *t, uint64_t deadline_ns, uint32_t slack_ns);
+void ktimer_cancel (struct ktimer *t);
+bool ktimer_pending (struct ktimer *t);
+
 void umap_bootstrap (struct umap *umap);
 void umap_init (struct umap *umap);
 void umap_free (struct umap *umap);
@@ -106,10 +106,14 @@ void plt_tmr_setctr (uint64_t ctr);
 /* Read timer period (in femtoseconds) */
 uint64_t plt_tmr_period (void);
 
-/* Set timer alarm in ALM ticks in the future. */
+/* If user space can read the timer counter directly (TSC, time CSR),
+   return true and set OFFSET to the value to add to it. */
+bool plt_tmr_userctr (uint64_t * offset);
+
+/* Set current CPU's timer alarm in ALM ticks in the future. */
 void plt_tmr_setalm (uint64_t alm);
 
-/* Disable timer alarm. */
+/* Disable current CPU's timer alarm. */
 void plt_tmr_clralm (void);
 
 /*
@@ -0,0 +1,65 @@
+/*
+  NUX: A kernel Library.
+  Copyright (C) 2019 Gianluca Guida, glguida@tlbflush.org
+
+  SPDX-License-Identifier:	BSD-2-Clause
+*/
+
+#ifndef _NUX_TIMEPAGE_H
+#define _NUX_TIMEPAGE_H
+
+#include <stdint.h>
+
+/*
+  NUX Time Page.
+
+  A read-only page that the kernel can map into user address spaces,
+  to let user programs read the time without entering the kernel.
+
+  This header is shared by kernel and user space, and depends only on
+  stdint.h.
+
+  The page is protected by a sequence counter: SEQ is odd while the
+  kernel updates it, and a reader must retry if SEQ was odd or changed
+  during the read.
+
+  If NUX_TIMEPAGE_USERCTR is set in FLAGS, the platform counter is
+  readable from user space (TSC on x86, time CSR on RISC-V), and the
+  current time in nanoseconds is:
+
+     nux_mulshift (counter + OFFSET, MULT, SHIFT)
+
+  Otherwise, NS holds the time of the last update (last timer
+  interrupt).
+*/
+
+#define NUX_TIMEPAGE_VERSION 1
+
+#define NUX_TIMEPAGE_USERCTR (1 << 0)
+
+struct nux_timepage
+{
+  uint32_t seq;
+  uint32_t version;
+  uint32_t flags;
+  uint32_t mult;
+  uint32_t shift;
+  uint32_t _pad;
+  uint64_t offset;
+  uint64_t ns;
+};
+
+/*
+  Computes A * MULT >> SHIFT without 128-bit arithmetic. SHIFT must
+  not be bigger than 32.
+*/
+static inline uint64_t
+nux_mulshift (uint64_t a, uint32_t mult, unsigned shift)
+{
+  uint64_t hi = (a >> 32) * mult;
+  uint64_t lo = (a & 0xffffffff) * mult;
+
+  return (hi << (32 - shift)) + (lo >> shift);
+}
+
+#endif
@@ -123,6 +123,22 @@ typedef struct umap
   struct hal_umap hal;
 } umap_t;
 
+/*
+  ktimer: Kernel Software Timer
+
+  A timer armed on a CPU's timer wheel. Its callback is called, on the
+  same CPU, from the timer interrupt once its deadline has passed.
+*/
+struct ktimer
+{
+  LIST_ENTRY (ktimer) list;
+  uint64_t expires;		/* Deadline, in wheel ticks. */
+  unsigned cpu;			/* CPU wheel, or -1 if not pending. */
+  unsigned slot;		/* Wheel slot. */
+  void (*fn) (struct ktimer *, void *);
+  void *arg;
+};
+
 /*
   Nux Symbols.
 
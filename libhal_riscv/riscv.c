@@ -329,6 +329,9 @@ hal_pcpu_enter (unsigned pcpuid)
   /* CPU is up and running. Switch to full interrupt handler. */
   set_stvec_final ();
 
+  /* Allow user to read the time counter. */
+  asm volatile ("csrs scounteren, %0"::"r" (SCOUNTEREN_TM));
+
   /* Allow Software Interrupts to fire now. */
   riscv_sie_kernel ();
   riscv_sstatus_sti ();
@@ -45,4 +45,8 @@
 
 #define SIP_SSIP SIE_SSIE
 
+#define SCOUNTEREN_CY (1L << 0)
+#define SCOUNTEREN_TM (1L << 1)
+#define SCOUNTEREN_IR (1L << 2)
+
 #endif
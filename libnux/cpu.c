@@ -54,6 +54,7 @@ cpu_add (uint16_t physid)
   cpuinfo->cpu_id = id;
   cpuinfo->phys_id = physid;
   cpuinfo->self = cpuinfo;
+  ktimer_cpuinit (&cpuinfo->ktw);
   hal_pcpu_add (physid, &cpuinfo->hal_cpu);
 
   cpus[id] = cpuinfo;
@@ -231,6 +232,13 @@ cpu_try_id (void)
     }
 }
 
+/* NUXST: OKCPU */
+struct ktimer_wheel *
+cpu_ktimer_wheel (void)
+{
+  return &cpu_curinfo ()->ktw;
+}
+
 /* NUXST: OKPLT */
 void
 cpu_setdata (void *ptr)
@@ -130,7 +130,9 @@ hal_entry_timer (struct hal_frame *f)
 {
   nuxperf_inc (&pnux_entry_timer);
   uctxt_t *uctxt = uctxt_getuser (f);
-  uctxt = entry_alarm (uctxt);
+  timepage_update ();
+  if (ktimer_run ())
+    uctxt = entry_alarm (uctxt);
   plt_eoi_timer ();
   return uctxt_frame (uctxt);
 }
@@ -116,6 +116,9 @@ void __attribute__((constructor (0))) _nux_sysinit (void)
      controllers. */
   plt_init ();
 
+  /* Setup time conversion from the PLT counter. */
+  timer_init ();
+
   nux_status_setfl (NUXST_OKPLT);
 
   /* Init CPUs operations */
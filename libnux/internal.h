@@ -53,6 +53,28 @@ tlbgen_cmp (tlbgen_t a, tlbgen_t b)
 }
 
 
+/*
+  Kernel timer wheel.
+*/
+#define KTW_SHIFT  10		/* Tick is 1024ns. */
+#define KTW_BITS   6
+#define KTW_SLOTS  (1 << KTW_BITS)
+#define KTW_MASK   (KTW_SLOTS - 1)
+#define KTW_LEVELS 6		/* Range: 2^46 ns, ~19.5 hours. */
+
+struct ktimer_wheel
+{
+  uint64_t clk;			/* Next tick to process. */
+  uint64_t armed;		/* Tick of the programmed alarm. */
+  bool running;
+  uint64_t bitmap[KTW_LEVELS];
+    LIST_HEAD (, ktimer) slots[KTW_LEVELS][KTW_SLOTS];
+
+  /* The timer_alarm() timer. */
+  struct ktimer alarm;
+  bool alarmfired;
+};
+
 /* 
    CPU management
 */
@@ -65,6 +87,9 @@ struct cpu_info
 
   struct umap *umap;
 
+  /* Timer wheel. */
+  struct ktimer_wheel ktw;
+
   /* Idle jmp_buf */
   jmp_buf idlejmp;
   bool idle;
@@ -110,6 +135,15 @@ void cpu_nmiop (void);
 void cpu_useraccess_checkpf (uaddr_t addr, hal_pfinfo_t info);
 unsigned cpu_try_id (void);
 void cpu_kmapupdate_broadcast (void);
+struct ktimer_wheel *cpu_ktimer_wheel (void);
+
+void timer_init (void);
+void timepage_update (void);
+void timer_hwalarm (uint64_t deadline);
+void timer_hwclear (void);
+
+void ktimer_cpuinit (struct ktimer_wheel *ktw);
+bool ktimer_run (void);
 
 void ktlbgen_markdirty (hal_tlbop_t op);
 tlbgen_t ktlbgen_global (void);
@@ -0,0 +1,340 @@
+/*
+  NUX: A kernel Library.
+  Copyright (C) 2019 Gianluca Guida, glguida@tlbflush.org
+
+  SPDX-License-Identifier:	BSD-2-Clause
+*/
+
+#include <assert.h>
+#include <string.h>
+#include <nux/nux.h>
+
+#include "internal.h"
+
+/*
+  Kernel Software Timers.
+
+  Per-CPU hierarchical timer wheel, with KTW_LEVELS levels of
+  KTW_SLOTS slots each. Level L slot covers 2^(KTW_BITS * L) ticks. A
+  timer is placed in the lowest level whose range covers its distance
+  from the current tick, and cascades down to a lower level when the
+  wheel reaches its slot.
+
+  The wheel is not advanced tick by tick: per-level bitmaps of
+  non-empty slots give the next tick at which something has to be
+  done (a timer expiring, or a slot to cascade), and the wheel jumps
+  there. The hardware alarm is programmed at that tick.
+
+  Wheels are only accessed from their own CPU, with interrupts
+  disabled, and need no locking.
+*/
+
+#define KTW_LVLSHIFT(_l) (KTW_BITS * (_l))
+#define KTW_RANGE (1ULL << (KTW_BITS * KTW_LEVELS))
+#define KTW_NONE ((uint64_t)-1)
+
+static inline uint64_t
+ns_to_tick (uint64_t ns)
+{
+  return (ns + (1 << KTW_SHIFT) - 1) >> KTW_SHIFT;
+}
+
+static inline uint64_t
+tick_to_ns (uint64_t tick)
+{
+  return tick << KTW_SHIFT;
+}
+
+static void
+ktw_insert (struct ktimer_wheel *ktw, struct ktimer *t)
+{
+  uint64_t e, delta;
+  unsigned lvl, slot;
+
+  e = t->expires < ktw->clk ? ktw->clk : t->expires;
+  delta = e - ktw->clk;
+  if (delta >= KTW_RANGE)
+    {
+      /* Park at the furthest slot, it will cascade again. */
+      delta = KTW_RANGE - 1;
+      e = ktw->clk + delta;
+    }
+
+  for (lvl = 0; lvl < KTW_LEVELS - 1; lvl++)
+    if (delta < (1ULL << KTW_LVLSHIFT (lvl + 1)))
+      break;
+
+  slot = (e >> KTW_LVLSHIFT (lvl)) & KTW_MASK;
+  LIST_INSERT_HEAD (&ktw->slots[lvl][slot], t, list);
+  ktw->bitmap[lvl] |= 1ULL << slot;
+  t->slot = lvl * KTW_SLOTS + slot;
+}
+
+static bool
+ktw_empty (struct ktimer_wheel *ktw)
+{
+  unsigned lvl;
+
+  for (lvl = 0; lvl < KTW_LEVELS; lvl++)
+    if (ktw->bitmap[lvl])
+      return false;
+  return true;
+}
+
+static void
+ktw_remove (struct ktimer_wheel *ktw, struct ktimer *t)
+{
+  unsigned lvl = t->slot / KTW_SLOTS;
+  unsigned slot = t->slot % KTW_SLOTS;
+
+  LIST_REMOVE (t, list);
+  if (LIST_EMPTY (&ktw->slots[lvl][slot]))
+    ktw->bitmap[lvl] &= ~(1ULL << slot);
+}
+
+/*
+  Return the first tick, not before the current one, at which a slot
+  must be processed, or KTW_NONE if the wheel is empty.
+*/
+static uint64_t
+ktw_next (struct ktimer_wheel *ktw)
+{
+  uint64_t next = KTW_NONE;
+  unsigned lvl;
+
+  for (lvl = 0; lvl < KTW_LEVELS; lvl++)
+    {
+      uint64_t b, bmp, tick;
+      unsigned start;
+
+      bmp = ktw->bitmap[lvl];
+      if (bmp == 0)
+	continue;
+
+      /* First slot boundary at this level not before clk. */
+      b = ktw->clk + (1ULL << KTW_LVLSHIFT (lvl)) - 1;
+      b >>= KTW_LVLSHIFT (lvl);
+      start = b & KTW_MASK;
+      if (start)
+	bmp = (bmp >> start) | (bmp << (KTW_SLOTS - start));
+
+      tick = (b + __builtin_ctzll (bmp)) << KTW_LVLSHIFT (lvl);
+      if (tick < next)
+	next = tick;
+    }
+
+  return next;
+}
+
+static void
+ktw_cascade (struct ktimer_wheel *ktw, unsigned lvl, unsigned slot)
+{
+  struct ktimer *t;
+  LIST_HEAD (, ktimer) tmp;
+
+  LIST_INIT (&tmp);
+  while ((t = LIST_FIRST (&ktw->slots[lvl][slot])) != NULL)
+    {
+      LIST_REMOVE (t, list);
+      LIST_INSERT_HEAD (&tmp, t, list);
+    }
+  ktw->bitmap[lvl] &= ~(1ULL << slot);
+
+  while ((t = LIST_FIRST (&tmp)) != NULL)
+    {
+      LIST_REMOVE (t, list);
+      ktw_insert (ktw, t);
+    }
+}
+
+/*
+  Process tick CLK: cascade higher levels whose slot boundary is
+  CLK, then expire level 0.
+*/
+static void
+ktw_tick (struct ktimer_wheel *ktw)
+{
+  uint64_t clk = ktw->clk;
+  struct ktimer *t;
+  unsigned lvl, slot;
+  LIST_HEAD (, ktimer) expired;
+
+  for (lvl = 1; lvl < KTW_LEVELS; lvl++)
+    {
+      if (clk & ((1ULL << KTW_LVLSHIFT (lvl)) - 1))
+	break;
+      slot = (clk >> KTW_LVLSHIFT (lvl)) & KTW_MASK;
+      if (ktw->bitmap[lvl] & (1ULL << slot))
+	ktw_cascade (ktw, lvl, slot);
+    }
+
+  slot = clk & KTW_MASK;
+  LIST_INIT (&expired);
+  while ((t = LIST_FIRST (&ktw->slots[0][slot])) != NULL)
+    {
+      LIST_REMOVE (t, list);
+      LIST_INSERT_HEAD (&expired, t, list);
+    }
+  ktw->bitmap[0] &= ~(1ULL << slot);
+
+  /* Timers added by the callbacks go to the next ticks. */
+  ktw->clk = clk + 1;
+
+  while ((t = LIST_FIRST (&expired)) != NULL)
+    {
+      LIST_REMOVE (t, list);
+      t->cpu = -1;
+      t->fn (t, t->arg);
+    }
+}
+
+static void
+ktw_program (struct ktimer_wheel *ktw)
+{
+  uint64_t next;
+
+  if (ktw->running)
+    return;
+
+  next = ktw_next (ktw);
+  if (next == ktw->armed)
+    return;
+
+  ktw->armed = next;
+  if (next == KTW_NONE)
+    timer_hwclear ();
+  else
+    timer_hwalarm (tick_to_ns (next));
+}
+
+static void
+ktimer_alarm_fn (struct ktimer *t, void *arg)
+{
+  struct ktimer_wheel *ktw = (struct ktimer_wheel *) arg;
+
+  ktw->alarmfired = true;
+}
+
+void
+ktimer_cpuinit (struct ktimer_wheel *ktw)
+{
+  unsigned i, j;
+
+  ktw->clk = 0;
+  ktw->armed = KTW_NONE;
+  ktw->running = false;
+  for (i = 0; i < KTW_LEVELS; i++)
+    {
+      ktw->bitmap[i] = 0;
+      for (j = 0; j < KTW_SLOTS; j++)
+	LIST_INIT (&ktw->slots[i][j]);
+    }
+  ktimer_init (&ktw->alarm, ktimer_alarm_fn, ktw);
+  ktw->alarmfired = false;
+}
+
+void
+ktimer_init (struct ktimer *t, void (*fn) (struct ktimer *, void *),
+	     void *arg)
+{
+  t->cpu = -1;
+  t->fn = fn;
+  t->arg = arg;
+}
+
+bool
+ktimer_pending (struct ktimer *t)
+{
+  return t->cpu != (unsigned) -1;
+}
+
+void
+ktimer_set (struct ktimer *t, uint64_t deadline_ns, uint32_t slack_ns)
+{
+  struct ktimer_wheel *ktw = cpu_ktimer_wheel ();
+  uint64_t e, emax, mask;
+
+  if (ktimer_pending (t))
+    ktimer_cancel (t);
+
+  /* Wheel not running since a while, no need to catch up. */
+  if (!ktw->running && ktw_empty (ktw))
+    ktw->clk = timer_gettime () >> KTW_SHIFT;
+
+  /*
+     Coalesce: pick the tick in [deadline, deadline + slack] with
+     the most trailing zeroes, so that nearby timers share it.
+   */
+  e = ns_to_tick (deadline_ns);
+  emax = (deadline_ns + slack_ns) >> KTW_SHIFT;
+  for (mask = 1; emax > e && (emax & ~mask) >= e; mask = (mask << 1) | 1)
+    emax &= ~mask;
+  if (emax > e)
+    e = emax;
+
+  t->expires = e;
+  t->cpu = cpu_id ();
+  ktw_insert (ktw, t);
+
+  if (ktw->armed == KTW_NONE || e < ktw->armed)
+    ktw_program (ktw);
+}
+
+void
+ktimer_cancel (struct ktimer *t)
+{
+  if (!ktimer_pending (t))
+    return;
+
+  assert (t->cpu == cpu_id ());
+  ktw_remove (cpu_ktimer_wheel (), t);
+  t->cpu = -1;
+
+  /* No reprogramming: an early alarm will find nothing to do. */
+}
+
+/*
+  Run expired timers on the current CPU, and reprogram the alarm.
+
+  Returns true if the timer_alarm() alarm expired.
+*/
+bool
+ktimer_run (void)
+{
+  struct ktimer_wheel *ktw = cpu_ktimer_wheel ();
+  uint64_t now, next;
+  bool alarm;
+
+  ktw->running = true;
+  now = timer_gettime () >> KTW_SHIFT;
+  while ((next = ktw_next (ktw)) <= now)
+    {
+      ktw->clk = next;
+      ktw_tick (ktw);
+    }
+  if (ktw->clk <= now)
+    ktw->clk = now + 1;
+  ktw->running = false;
+
+  /* The programmed alarm has fired. */
+  ktw->armed = KTW_NONE;
+  ktw_program (ktw);
+
+  alarm = ktw->alarmfired;
+  ktw->alarmfired = false;
+  return alarm;
+}
+
+void
+timer_alarm (uint32_t time_ns)
+{
+  struct ktimer_wheel *ktw = cpu_ktimer_wheel ();
+
+  ktimer_set (&ktw->alarm, timer_gettime () + time_ns, 0);
+}
+
+void
+timer_clear (void)
+{
+  ktimer_cancel (&cpu_ktimer_wheel ()->alarm);
+}
@@ -5,21 +5,151 @@
   SPDX-License-Identifier:	BSD-2-Clause
 */
 
+#include <assert.h>
+#include <inttypes.h>
+#include <string.h>
 #include <nux/nux.h>
 #include <nux/plt.h>
+#include <nux/timepage.h>
 #include "internal.h"
 
+/*
+  Clock conversion.
+
+  Counter ticks and nanoseconds are converted with a multiply and a
+  shift, precomputed at boot from the PLT counter period, instead of a
+  64-bit division on every call.
+*/
+
+static uint32_t ns_mult;	/* Ticks to ns. */
+static unsigned ns_shift;
+static uint32_t tck_mult;	/* ns to ticks. */
+static unsigned tck_shift;
+
+static pfn_t timepage_pfn = PFN_INVALID;
+static struct nux_timepage *timepage = NULL;
+
+static void
+calc_mulshift (uint32_t * mult, unsigned *shift, uint64_t to, uint64_t from)
+{
+  unsigned s;
+  uint64_t m = 0;
+
+  /* Reduce to 32-bit operands. */
+  while (to > UINT32_MAX || from > UINT32_MAX)
+    {
+      to >>= 1;
+      from >>= 1;
+    }
+
+  for (s = 32; s > 0; s--)
+    {
+      m = (to << s) / from;
+      if (m <= UINT32_MAX)
+	break;
+    }
+  *mult = (uint32_t) m;
+  *shift = s;
+}
+
 void
-timer_alarm (uint32_t time_ns)
+timer_init (void)
 {
   uint64_t period_fs = plt_tmr_period ();
-  uint64_t time_fs = 1000000LL * time_ns;
 
-  plt_tmr_setalm ((time_fs + period_fs - 1) / period_fs);
+  assert (period_fs != 0);
+  calc_mulshift (&ns_mult, &ns_shift, period_fs, 1000000);
+  calc_mulshift (&tck_mult, &tck_shift, 1000000, period_fs);
+  info ("Timer: period %" PRIu64 " fs, ns = ticks * %u >> %u",
+	period_fs, (unsigned) ns_mult, ns_shift);
+
+  timepage_pfn = pfn_alloc (0);
+  if (timepage_pfn == PFN_INVALID)
+    {
+      warn ("Timer: can't allocate time page.");
+      return;
+    }
+  timepage = kva_map (timepage_pfn, HAL_PTE_P | HAL_PTE_W);
+  memset (timepage, 0, PAGE_SIZE);
+  timepage->version = NUX_TIMEPAGE_VERSION;
+  timepage->mult = ns_mult;
+  timepage->shift = ns_shift;
+  timepage_update ();
 }
 
+/*
+  Update the time page.
+
+  Called on timer interrupts, possibly on many CPUs at once: only one
+  CPU updates the page, the others skip.
+*/
 void
-timer_clear (void)
+timepage_update (void)
+{
+  uint32_t seq;
+  uint64_t offset;
+
+  if (timepage == NULL)
+    return;
+
+  seq = __atomic_load_n (&timepage->seq, __ATOMIC_RELAXED);
+  if ((seq & 1)
+      || !__atomic_compare_exchange_n (&timepage->seq, &seq, seq + 1, false,
+				       __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    return;
+  /* Odd sequence must be visible before the data. */
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+
+  if (plt_tmr_userctr (&offset))
+    {
+      timepage->flags = NUX_TIMEPAGE_USERCTR;
+      timepage->offset = offset;
+    }
+  else
+    {
+      timepage->flags = 0;
+      timepage->offset = 0;
+    }
+  timepage->ns = timer_gettime ();
+
+  __atomic_store_n (&timepage->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+bool
+timer_umap (struct umap *umap, uaddr_t va)
+{
+  pfn_t opfn;
+
+  if (timepage_pfn == PFN_INVALID)
+    return false;
+
+  if (!umap_map (umap, va, timepage_pfn, HAL_PTE_P | HAL_PTE_U, &opfn))
+    return false;
+
+  if (opfn != PFN_INVALID)
+    umap_commit (umap);
+  return true;
+}
+
+/*
+  Program the hardware alarm at absolute time DEADLINE (ns).
+*/
+void
+timer_hwalarm (uint64_t deadline)
+{
+  uint64_t now = timer_gettime ();
+  uint64_t delta = deadline > now ? deadline - now : 0;
+
+  /* Far deadlines will just reprogram on wake-up. */
+  if (delta > UINT32_MAX)
+    delta = UINT32_MAX;
+
+  /* Round up: never fire before DEADLINE. */
+  plt_tmr_setalm (nux_mulshift (delta, tck_mult, tck_shift) + 1);
+}
+
+void
+timer_hwclear (void)
 {
   plt_tmr_clralm ();
 }
@@ -27,8 +157,5 @@ timer_clear (void)
 uint64_t
 timer_gettime (void)
 {
-  uint64_t period_fs = plt_tmr_period ();
-  uint64_t ctr = plt_tmr_ctr ();
-
-  return (period_fs * ctr) / 1000000;
+  return nux_mulshift (plt_tmr_ctr (), ns_mult, ns_shift);
 }
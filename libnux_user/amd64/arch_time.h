@@ -0,0 +1,8 @@
+static inline uint64_t
+__nux_readctr (void)
+{
+  uint32_t lo, hi;
+
+  asm volatile ("rdtsc":"=a" (lo), "=d" (hi));
+  return (uint64_t) hi << 32 | lo;
+}
@@ -0,0 +1,13 @@
+#ifndef __NUX_TIME_H
+#define __NUX_TIME_H
+
+#include <stdint.h>
+#include <nux/timepage.h>
+
+/*
+  Read the current time in nanoseconds from the time page TP mapped
+  by the kernel, without entering the kernel.
+*/
+uint64_t nux_gettime (const struct nux_timepage *tp);
+
+#endif
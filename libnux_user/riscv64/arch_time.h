@@ -0,0 +1,8 @@
+static inline uint64_t
+__nux_readctr (void)
+{
+  uint64_t time;
+
+  asm volatile ("rdtime %0":"=r" (time));
+  return time;
+}
@@ -0,0 +1,26 @@
+#include <nux/time.h>
+#include <arch_time.h>
+
+uint64_t
+nux_gettime (const struct nux_timepage *tp)
+{
+  uint32_t seq;
+  uint64_t ns;
+
+  for (;;)
+    {
+      seq = __atomic_load_n (&tp->seq, __ATOMIC_ACQUIRE);
+      if (seq & 1)
+	continue;
+
+      if (tp->flags & NUX_TIMEPAGE_USERCTR)
+	ns = nux_mulshift (__nux_readctr () + tp->offset, tp->mult,
+			   tp->shift);
+      else
+	ns = tp->ns;
+
+      __atomic_thread_fence (__ATOMIC_ACQUIRE);
+      if (__atomic_load_n (&tp->seq, __ATOMIC_RELAXED) == seq)
+	return ns;
+    }
+}
@@ -19,7 +19,8 @@
 #define APIC_VECT_MAX     hal_vect_max()
 #define APIC_VECT_IPIMAX  1
 #define APIC_VECT_IPIBASE (APIC_VECT_MAX - APIC_VECT_IPIMAX)
+#define APIC_VECT_TMR     (APIC_VECT_IPIBASE - 1)
 #define APIC_VECT_IRQBASE 0x28
-#define APIC_VECT_IRQMAX (APIC_VECT_IPIBASE - APIC_VECT_IRQBASE)
+#define APIC_VECT_IRQMAX (APIC_VECT_TMR - APIC_VECT_IRQBASE)
 
 #endif
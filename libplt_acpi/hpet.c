@@ -163,38 +163,38 @@ hpet_init (paddr_t hpetpa)
 }
 
 uint64_t
-plt_tmr_ctr (void)
+hpet_ctr (void)
 {
-  return hpet_read (0xf0);
+  return hpet_read (REG_COUNTER);
 }
 
 void
-plt_tmr_setctr (uint64_t ctr)
+hpet_setctr (uint64_t ctr)
 {
   hpet_pause ();
-  hpet_write (0xf0, ctr);
+  hpet_write (REG_COUNTER, ctr);
   hpet_resume ();
 }
 
 uint64_t
-plt_tmr_period (void)
+hpet_period (void)
 {
   return period;
 }
 
 void
-plt_tmr_setalm (uint64_t alm)
+hpet_setalm (uint64_t alm)
 {
   if (alm == 0)
     alm = 1;
   hpet_pause ();
-  hpet_write (REG_TMRCMP (TMR), plt_tmr_ctr () + alm);
+  hpet_write (REG_TMRCMP (TMR), hpet_ctr () + alm);
   hpet_write (REG_TMRCAP (TMR), tmrcfg | INT_ENB_CNF);
   hpet_resume ();
 }
 
 void
-plt_tmr_clralm (void)
+hpet_clralm (void)
 {
   hpet_write (REG_TMRCAP (TMR), tmrcfg & ~INT_ENB_CNF);
 }
@@ -17,6 +17,11 @@ void lapic_init (uint64_t, unsigned);
 void lapic_add (uint16_t, uint16_t);
 void lapic_add_nmi (uint8_t, int);
 void lapic_eoi (void);
+void lapic_tmr_calstart (void);
+uint32_t lapic_tmr_calend (void);
+bool lapic_tmr_init (uint32_t src, uint32_t tsc, uint32_t lapic);
+void lapic_tmr_setalm (uint64_t alm);
+void lapic_tmr_clralm (void);
 
 void ioapic_init (unsigned no);
 void ioapic_add (unsigned num, uint64_t base, unsigned irqbase);
@@ -36,5 +41,91 @@ void hw_reset_vector (uint32_t start);
 bool hpet_init (paddr_t hpetpa);
 void hpet_doirq (void);
 bool acpi_hpet_scan (void);
+uint64_t hpet_ctr (void);
+void hpet_setctr (uint64_t ctr);
+uint64_t hpet_period (void);
+void hpet_setalm (uint64_t alm);
+void hpet_clralm (void);
+
+void tmr_init (void);
+
+/*
+  X86 CPU helpers.
+*/
+
+#define CPUID1_ECX_TSCDEADLINE (1L << 24)
+#define CPUID80000007_EDX_INVTSC (1L << 8)
+
+#define MSR_IA32_TSC_DEADLINE 0x6e0
+
+static inline void
+x86_cpuid (uint32_t leaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx,
+	   uint32_t *edx)
+{
+  uint32_t a, b, c, d;
+
+  asm volatile ("cpuid":"=a" (a), "=b" (b), "=c" (c), "=d" (d):"a" (leaf),
+		"c" (0));
+  if (eax)
+    *eax = a;
+  if (ebx)
+    *ebx = b;
+  if (ecx)
+    *ecx = c;
+  if (edx)
+    *edx = d;
+}
+
+static inline uint64_t
+x86_rdtsc (void)
+{
+  uint32_t lo, hi;
+
+  asm volatile ("rdtsc":"=a" (lo), "=d" (hi));
+  return (uint64_t) hi << 32 | lo;
+}
+
+static inline void
+x86_wrmsr (uint32_t ecx, uint64_t val)
+{
+  asm volatile ("wrmsr"::"c" (ecx), "a" ((uint32_t) val),
+		"d" ((uint32_t) (val >> 32)));
+}
+
+/*
+  Multiply-shift conversion between two counters.
+
+  Computes A * MULT >> SHIFT without 128-bit arithmetic. SHIFT must
+  not be bigger than 32.
+*/
+static inline uint64_t
+mulshift (uint64_t a, uint32_t mult, unsigned shift)
+{
+  uint64_t hi = (a >> 32) * mult;
+  uint64_t lo = (a & 0xffffffff) * mult;
+
+  return (hi << (32 - shift)) + (lo >> shift);
+}
+
+/*
+  Calculate MULT and SHIFT so that mulshift(x, MULT, SHIFT) converts
+  FROM units into TO units, with the best precision allowed by a
+  32-bit multiplier.
+*/
+static inline void
+calc_mulshift (uint32_t * mult, unsigned *shift, uint32_t to, uint32_t from)
+{
+  unsigned s;
+  uint64_t m = 0;
+
+  for (s = 32; s > 0; s--)
+    {
+      m = ((uint64_t) to << s) / from;
+      if (m <= UINT32_MAX)
+	break;
+    }
+  *mult = (uint32_t) m;
+  *shift = s;
+}
 
 #endif
@@ -64,6 +64,10 @@ struct lapic_desc
 #define L_TMR_CC	0x390
 #define L_TMR_DIV	0x3e0
 
+#define L_LVT_MASKED	(1L << 16)
+#define L_LVT_TSCDL	(2L << 17)	/* TSC-Deadline timer mode. */
+#define L_TMR_DIV16	0x3
+
 #define LAPIC_SIZE      (1UL << 12)
 
 static uint32_t
@@ -89,6 +93,128 @@ lapic_getcurrent (void)
   return (unsigned) (lapic_read (L_IDREG) >> 24);
 }
 
+
+/*
+ * Local APIC Timer.
+ *
+ * Every CPU has its own alarm, so that arming a timer doesn't require
+ * reprogramming (and pausing) the global HPET. Alarms are requested
+ * in PLT counter ticks, and converted at boot-calibrated rates into
+ * either TSC ticks (TSC-Deadline mode, a single WRMSR to arm) or LAPIC
+ * timer ticks (One-shot mode).
+ */
+
+static bool lapic_tmr_ok = false;
+static bool lapic_tmr_tscdl = false;
+static uint32_t lapic_tmr_mult;
+static unsigned lapic_tmr_shift;
+
+static void
+lapic_tmr_configure (void)
+{
+  if (!lapic_tmr_ok)
+    return;
+
+  lapic_write (L_TMR_IC, 0);
+  lapic_write (L_TMR_DIV, L_TMR_DIV16);
+  if (lapic_tmr_tscdl)
+    {
+      lapic_write (L_LVT_TIMER, L_LVT_TSCDL | APIC_VECT_TMR);
+      /* Mode change must be visible before the first deadline WRMSR. */
+      asm volatile ("mfence":::"memory");
+    }
+  else
+    lapic_write (L_LVT_TIMER, APIC_VECT_TMR);
+}
+
+/*
+  Calibration: start the LAPIC timer from its maximum count, masked.
+*/
+void
+lapic_tmr_calstart (void)
+{
+  if (lapic_base == NULL)
+    return;
+
+  lapic_write (L_LVT_TIMER, L_LVT_MASKED | APIC_VECT_TMR);
+  lapic_write (L_TMR_DIV, L_TMR_DIV16);
+  lapic_write (L_TMR_IC, UINT32_MAX);
+}
+
+/*
+  Calibration: stop the LAPIC timer, return the elapsed ticks.
+*/
+uint32_t
+lapic_tmr_calend (void)
+{
+  uint32_t cc;
+
+  if (lapic_base == NULL)
+    return 0;
+
+  cc = lapic_read (L_TMR_CC);
+  lapic_write (L_TMR_IC, 0);
+  return UINT32_MAX - cc;
+}
+
+/*
+  Enable per-CPU alarms. SRC, TSC and LAPIC are the ticks counted
+  during the same calibration interval by the PLT counter, the TSC
+  and the LAPIC timer.
+*/
+bool
+lapic_tmr_init (uint32_t src, uint32_t tsc, uint32_t lapic)
+{
+  uint32_t ecx;
+
+  if (lapic_base == NULL || src == 0)
+    return false;
+
+  x86_cpuid (1, NULL, NULL, &ecx, NULL);
+  lapic_tmr_tscdl = !!(ecx & CPUID1_ECX_TSCDEADLINE);
+
+  if (lapic_tmr_tscdl)
+    calc_mulshift (&lapic_tmr_mult, &lapic_tmr_shift, tsc, src);
+  else if (lapic != 0)
+    calc_mulshift (&lapic_tmr_mult, &lapic_tmr_shift, lapic, src);
+  else
+    return false;
+
+  info ("Using per-CPU LAPIC timer (%s mode)",
+	lapic_tmr_tscdl ? "TSC-Deadline" : "One-shot");
+  lapic_tmr_ok = true;
+  return true;
+}
+
+void
+lapic_tmr_setalm (uint64_t alm)
+{
+  uint64_t ticks = mulshift (alm, lapic_tmr_mult, lapic_tmr_shift);
+
+  if (ticks == 0)
+    ticks = 1;
+
+  if (lapic_tmr_tscdl)
+    {
+      x86_wrmsr (MSR_IA32_TSC_DEADLINE, x86_rdtsc () + ticks);
+    }
+  else
+    {
+      if (ticks > UINT32_MAX)
+	ticks = UINT32_MAX;
+      lapic_write (L_TMR_IC, ticks);
+    }
+}
+
+void
+lapic_tmr_clralm (void)
+{
+  if (lapic_tmr_tscdl)
+    x86_wrmsr (MSR_IA32_TSC_DEADLINE, 0);
+  else
+    lapic_write (L_TMR_IC, 0);
+}
+
 static void
 lapic_configure (void)
 {
@@ -112,6 +238,8 @@ lapic_configure (void)
     }
   /* Enable LAPIC */
   lapic_write (L_MISC, lapic_read (L_MISC) | 0x100);
+
+  lapic_tmr_configure ();
 }
 
 static void
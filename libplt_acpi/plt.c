@@ -34,6 +34,7 @@ plt_init (void)
   gsi_start ();
 
   acpi_hpet_scan ();
+  tmr_init ();
 }
 
 void
@@ -61,6 +62,10 @@ plt_interrupt (unsigned vect, struct hal_frame *f)
     {
       r = hal_entry_ipi (f);
     }
+  else if (vect == APIC_VECT_TMR)
+    {
+      r = hal_entry_timer (f);
+    }
   else if (vect >= APIC_VECT_IRQBASE)
     {
       unsigned irq = vect - APIC_VECT_IRQBASE;
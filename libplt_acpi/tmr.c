@@ -0,0 +1,159 @@
+/*
+  NUX: A kernel Library.
+  Copyright (C) 2019 Gianluca Guida, glguida@tlbflush.org
+
+  SPDX-License-Identifier:	BSD-2-Clause
+*/
+
+#include <inttypes.h>
+
+#include "internal.h"
+#include <nux/nux.h>
+
+/*
+  PLT Timer.
+
+  The PLT counter is the TSC if it is invariant (constant rate, not
+  stopped in deep C-states), calibrated against the HPET at boot. A
+  TSC read is a single unprivileged instruction, while an HPET read is
+  a retried pair of uncached MMIO reads. Otherwise, the counter is the
+  HPET itself.
+
+  Alarms are per-CPU, programmed on the Local APIC timer, unless it
+  failed calibration: in that case fall back to the global HPET
+  comparator, which only works if the counter is the HPET.
+*/
+
+#define TMR_CALIBRATE_NS 10000000	/* 10ms */
+
+static bool tmr_tsc = false;
+static bool tmr_lapic = false;
+static uint64_t tsc_period = 0;
+static uint64_t tsc_offset = 0;
+
+static bool
+tsc_invariant (void)
+{
+  uint32_t eax, edx;
+
+  x86_cpuid (0x80000000, &eax, NULL, NULL, NULL);
+  if (eax < 0x80000007)
+    return false;
+
+  x86_cpuid (0x80000007, NULL, NULL, NULL, &edx);
+  return !!(edx & CPUID80000007_EDX_INVTSC);
+}
+
+void
+tmr_init (void)
+{
+  uint64_t period, target, h0, h1, t0, t1, ns;
+  uint32_t l1;
+
+  period = hpet_period ();
+  if (period == 0)
+    return;
+
+  /*
+     Calibrate TSC and LAPIC timer against the HPET. Start on an HPET
+     tick edge.
+   */
+  target = ((uint64_t) TMR_CALIBRATE_NS * 1000000 + period - 1) / period;
+  h0 = hpet_ctr ();
+  while ((h1 = hpet_ctr ()) == h0)
+    hal_cpu_relax ();
+  h0 = h1;
+  lapic_tmr_calstart ();
+  t0 = x86_rdtsc ();
+
+  while ((h1 = hpet_ctr ()) - h0 < target)
+    hal_cpu_relax ();
+
+  t1 = x86_rdtsc ();
+  l1 = lapic_tmr_calend ();
+
+  h1 -= h0;
+  t1 -= t0;
+  if (h1 > UINT32_MAX || t1 > UINT32_MAX || t1 == 0)
+    {
+      warn ("Timer calibration failed. Using HPET only.");
+      return;
+    }
+
+  ns = h1 * period / 1000000;
+  info ("TSC frequency: %" PRIu64 " kHz (%s)", t1 * 1000000 / ns,
+	tsc_invariant ()? "invariant" : "variant");
+  info ("LAPIC timer frequency: %" PRIu64 " kHz (div 16)",
+	(uint64_t) l1 * 1000000 / ns);
+
+  if (tsc_invariant ())
+    {
+      tsc_period = h1 * period / t1;
+      tsc_offset = hpet_ctr () * period / tsc_period - x86_rdtsc ();
+      tmr_tsc = true;
+      info ("Using TSC as PLT counter (period %" PRIu64 " fs)", tsc_period);
+    }
+
+  tmr_lapic = lapic_tmr_init (tmr_tsc ? t1 : h1, t1, l1);
+  if (!tmr_lapic)
+    {
+      if (tmr_tsc)
+	fatal ("No usable timer alarm.");
+      info ("Using global HPET alarm.");
+    }
+}
+
+uint64_t
+plt_tmr_ctr (void)
+{
+  if (tmr_tsc)
+    return x86_rdtsc () + tsc_offset;
+
+  return hpet_ctr ();
+}
+
+void
+plt_tmr_setctr (uint64_t ctr)
+{
+  if (tmr_tsc)
+    tsc_offset = ctr - x86_rdtsc ();
+  else
+    hpet_setctr (ctr);
+}
+
+uint64_t
+plt_tmr_period (void)
+{
+  if (tmr_tsc)
+    return tsc_period;
+
+  return hpet_period ();
+}
+
+bool
+plt_tmr_userctr (uint64_t * offset)
+{
+  if (!tmr_tsc)
+    return false;
+
+  *offset = tsc_offset;
+  return true;
+}
+
+void
+plt_tmr_setalm (uint64_t alm)
+{
+  if (tmr_lapic)
+    lapic_tmr_setalm (alm);
+  else
+    hpet_setalm (alm);
+}
+
+void
+plt_tmr_clralm (void)
+{
+  if (tmr_lapic)
+    lapic_tmr_clralm ();
+  else
+    hpet_clralm ();
+}
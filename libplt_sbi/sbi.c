@@ -443,6 +443,13 @@ plt_tmr_setctr (uint64_t alm)
   tmr_offset = alm - time;
 }
 
+bool
+plt_tmr_userctr (uint64_t * offset)
+{
+  *offset = tmr_offset;
+  return true;
+}
+
 void
 plt_tmr_setalm (uint64_t alm)
 {